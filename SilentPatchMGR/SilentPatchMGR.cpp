@@ -8,9 +8,14 @@
 #include <shlwapi.h>
 #include <ShlObj.h>
 #include <shellapi.h>
+#include <algorithm>
 #include <array>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <Commctrl.h>
 
@@ -59,6 +64,545 @@ const std::wstring& GetINIPath()
 	return path;
 }
 
+namespace UnchangedWriteFix
+{
+	namespace internal
+	{
+		// Streaming XXH64. On Win32 its 64-bit multiplies are split into several 32-bit ones, so XXH32 would be faster,
+		// but saves are small enough for this not to matter and 64 bits make collisions between two saves a non-issue
+		class ContentHash
+		{
+		public:
+			ContentHash()
+			{
+				m_lanes[0] = PRIME1 + PRIME2;
+				m_lanes[1] = PRIME2;
+				m_lanes[2] = 0;
+				m_lanes[3] = 0 - PRIME1;
+			}
+
+			void Update( const void* data, size_t size )
+			{
+				if ( size == 0 )
+				{
+					return;
+				}
+
+				const uint8_t* input = static_cast<const uint8_t*>(data);
+				m_totalSize += size;
+
+				// Complete a stripe left over from the previous call first
+				if ( m_stripeSize != 0 )
+				{
+					const size_t toCopy = std::min( size, STRIPE_SIZE - m_stripeSize );
+					memcpy( m_stripe + m_stripeSize, input, toCopy );
+					m_stripeSize += toCopy;
+					input += toCopy;
+					size -= toCopy;
+
+					if ( m_stripeSize < STRIPE_SIZE )
+					{
+						return;
+					}
+					ConsumeStripe( m_stripe );
+					m_stripeSize = 0;
+				}
+
+				for ( ; size >= STRIPE_SIZE; input += STRIPE_SIZE, size -= STRIPE_SIZE )
+				{
+					ConsumeStripe( input );
+				}
+
+				memcpy( m_stripe, input, size );
+				m_stripeSize = size;
+			}
+
+			uint64_t Digest() const
+			{
+				uint64_t hash;
+				if ( m_totalSize >= STRIPE_SIZE )
+				{
+					hash = Rotl( m_lanes[0], 1 ) + Rotl( m_lanes[1], 7 ) + Rotl( m_lanes[2], 12 ) + Rotl( m_lanes[3], 18 );
+					for ( uint64_t lane : m_lanes )
+					{
+						hash ^= Round( 0, lane );
+						hash = hash * PRIME1 + PRIME4;
+					}
+				}
+				else
+				{
+					hash = PRIME5;
+				}
+				hash += m_totalSize;
+
+				const uint8_t* input = m_stripe;
+				size_t size = m_stripeSize;
+				for ( ; size >= 8; input += 8, size -= 8 )
+				{
+					hash ^= Round( 0, Read<uint64_t>( input ) );
+					hash = Rotl( hash, 27 ) * PRIME1 + PRIME4;
+				}
+				if ( size >= 4 )
+				{
+					hash ^= Read<uint32_t>( input ) * PRIME1;
+					hash = Rotl( hash, 23 ) * PRIME2 + PRIME3;
+					input += 4;
+					size -= 4;
+				}
+				for ( ; size != 0; input++, size-- )
+				{
+					hash ^= *input * PRIME5;
+					hash = Rotl( hash, 11 ) * PRIME1;
+				}
+
+				hash ^= hash >> 33;
+				hash *= PRIME2;
+				hash ^= hash >> 29;
+				hash *= PRIME3;
+				hash ^= hash >> 32;
+				return hash;
+			}
+
+		private:
+			static constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+			static constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+			static constexpr uint64_t PRIME3 = 0x165667B19E3779F9ull;
+			static constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ull;
+			static constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ull;
+			static constexpr size_t STRIPE_SIZE = 32;
+
+			static uint64_t Rotl( uint64_t value, int shift )
+			{
+				return (value << shift) | (value >> (64 - shift));
+			}
+
+			static uint64_t Round( uint64_t acc, uint64_t input )
+			{
+				acc += input * PRIME2;
+				acc = Rotl( acc, 31 );
+				return acc * PRIME1;
+			}
+
+			template<typename T>
+			static T Read( const uint8_t* ptr )
+			{
+				T value;
+				memcpy( &value, ptr, sizeof(value) );
+				return value;
+			}
+
+			void ConsumeStripe( const uint8_t* stripe )
+			{
+				for ( size_t i = 0; i < std::size(m_lanes); i++ )
+				{
+					m_lanes[i] = Round( m_lanes[i], Read<uint64_t>( stripe + i * sizeof(uint64_t) ) );
+				}
+			}
+
+			uint64_t m_lanes[4];
+			uint8_t m_stripe[STRIPE_SIZE];
+			size_t m_stripeSize = 0;
+			uint64_t m_totalSize = 0;
+		};
+
+		// What we last saw on disk, kept in full so writes can be compared as they come in
+		struct FileContents
+		{
+			uint64_t hash;
+			FILETIME lastWriteTime;
+			std::vector<uint8_t> contents;
+		};
+
+		// Writes the game issued to a handle. They are held back for as long as they match what's on disk already
+		struct PendingWrite
+		{
+			std::wstring path;
+			std::shared_ptr<const FileContents> known;
+			std::vector<uint8_t> contents;
+			bool diverged = false;
+			bool failed = false;
+		};
+
+		std::mutex mutex;
+		std::map<std::wstring, std::shared_ptr<const FileContents>> knownFiles;
+		std::map<HANDLE, PendingWrite> pendingWrites;
+
+		uint64_t WritesAvoided = 0;
+		uint64_t BytesAvoided = 0;
+
+		bool GetFileState( HANDLE hFile, uint64_t& size, FILETIME& lastWriteTime )
+		{
+			BY_HANDLE_FILE_INFORMATION info;
+			if ( GetFileInformationByHandle( hFile, &info ) == FALSE )
+			{
+				return false;
+			}
+			size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+			lastWriteTime = info.ftLastWriteTime;
+			return true;
+		}
+
+		bool GetFileState( LPCWSTR path, uint64_t& size, FILETIME& lastWriteTime )
+		{
+			WIN32_FILE_ATTRIBUTE_DATA data;
+			if ( GetFileAttributesExW( path, GetFileExInfoStandard, &data ) == FALSE )
+			{
+				return false;
+			}
+			size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+			lastWriteTime = data.ftLastWriteTime;
+			return true;
+		}
+
+		uint64_t HashContents( const std::vector<uint8_t>& contents )
+		{
+			ContentHash hasher;
+			hasher.Update( contents.data(), contents.size() );
+			return hasher.Digest();
+		}
+
+		std::shared_ptr<const FileContents> ReadFromDisk( HANDLE hFile, uint64_t size, const FILETIME& lastWriteTime )
+		{
+			auto result = std::make_shared<FileContents>();
+			result->lastWriteTime = lastWriteTime;
+			result->contents.resize( static_cast<size_t>(size) );
+
+			ContentHash hasher;
+			size_t bytesTotal = 0;
+			while ( bytesTotal < result->contents.size() )
+			{
+				const DWORD bytesToRead = static_cast<DWORD>(std::min<size_t>( result->contents.size() - bytesTotal, 64 * 1024 ));
+				DWORD bytesRead;
+				if ( ReadFile( hFile, result->contents.data() + bytesTotal, bytesToRead, &bytesRead, nullptr ) == FALSE || bytesRead == 0 )
+				{
+					return nullptr;
+				}
+				hasher.Update( result->contents.data() + bytesTotal, bytesRead );
+				bytesTotal += bytesRead;
+			}
+
+			if ( SetFilePointer( hFile, 0, nullptr, FILE_BEGIN ) == INVALID_SET_FILE_POINTER )
+			{
+				return nullptr;
+			}
+
+			result->hash = hasher.Digest();
+			return result;
+		}
+
+		bool WriteContents( HANDLE hFile, const std::vector<uint8_t>& contents )
+		{
+			if ( SetFilePointer( hFile, 0, nullptr, FILE_BEGIN ) == INVALID_SET_FILE_POINTER )
+			{
+				return false;
+			}
+
+			const uint8_t* data = contents.data();
+			size_t bytesLeft = contents.size();
+			while ( bytesLeft != 0 )
+			{
+				DWORD bytesWritten;
+				if ( WriteFile( hFile, data, static_cast<DWORD>(bytesLeft), &bytesWritten, nullptr ) == FALSE )
+				{
+					return false;
+				}
+				if ( bytesWritten == 0 )
+				{
+					SetLastError( ERROR_WRITE_FAULT );
+					return false;
+				}
+				data += bytesWritten;
+				bytesLeft -= bytesWritten;
+			}
+			return SetEndOfFile( hFile ) != FALSE;
+		}
+
+		void StoreContents( std::vector<uint8_t>& contents, size_t offset, LPCVOID data, DWORD size )
+		{
+			if ( contents.size() < offset + size )
+			{
+				contents.resize( offset + size );
+			}
+			memcpy( contents.data() + offset, data, size );
+		}
+
+		// Finds all call dword ptr [WriteFile] instructions between begin and end, returns pointers to their operands
+		std::vector<void*> FindWriteFileCalls( uint8_t* begin, uint8_t* end )
+		{
+			std::vector<void*> result;
+
+			const void* writeFile = GetProcAddress( GetModuleHandleW( L"kernel32.dll" ), "WriteFile" );
+			uint8_t* moduleBegin = reinterpret_cast<uint8_t*>(GetModuleHandle( nullptr ));
+			uint8_t* moduleEnd = moduleBegin + reinterpret_cast<PIMAGE_NT_HEADERS>(moduleBegin + reinterpret_cast<PIMAGE_DOS_HEADER>(moduleBegin)->e_lfanew)->OptionalHeader.SizeOfImage;
+
+			for ( uint8_t* ptr = begin; ptr + 6 <= end; ptr++ )
+			{
+				if ( ptr[0] != 0xFF || ptr[1] != 0x15 )
+				{
+					continue;
+				}
+
+				void** importSlot = *reinterpret_cast<void***>(ptr + 2);
+				if ( reinterpret_cast<uint8_t*>(importSlot) >= moduleBegin && reinterpret_cast<uint8_t*>(importSlot + 1) <= moduleEnd && *importSlot == writeFile )
+				{
+					result.push_back( ptr + 2 );
+				}
+			}
+			return result;
+		}
+	}
+
+	// Opens a file the game is about to overwrite without truncating it, so writes matching what's already there can be held back
+	HANDLE CreateFileForWrite( LPCWSTR lpFileName, DWORD dwDesiredAccess, DWORD dwShareMode, LPSECURITY_ATTRIBUTES lpSecurityAttributes, DWORD dwCreationDisposition, DWORD dwFlagsAndAttributes, HANDLE hTemplateFile )
+	{
+		using namespace internal;
+
+		const bool overwrites = (dwDesiredAccess & GENERIC_WRITE) != 0 && (dwCreationDisposition == CREATE_ALWAYS || dwCreationDisposition == TRUNCATE_EXISTING);
+		if ( !overwrites )
+		{
+			return CreateFileW( lpFileName, dwDesiredAccess, dwShareMode, lpSecurityAttributes, dwCreationDisposition, dwFlagsAndAttributes, hTemplateFile );
+		}
+
+		const DWORD creationDisposition = dwCreationDisposition == CREATE_ALWAYS ? OPEN_ALWAYS : OPEN_EXISTING;
+		HANDLE hFile = CreateFileW( lpFileName, dwDesiredAccess|GENERIC_READ, dwShareMode, lpSecurityAttributes, creationDisposition, dwFlagsAndAttributes, hTemplateFile );
+		if ( hFile == INVALID_HANDLE_VALUE )
+		{
+			return CreateFileW( lpFileName, dwDesiredAccess, dwShareMode, lpSecurityAttributes, dwCreationDisposition, dwFlagsAndAttributes, hTemplateFile );
+		}
+
+		// Preserve ERROR_ALREADY_EXISTS for the game
+		const DWORD lastError = GetLastError();
+
+		std::shared_ptr<const FileContents> known;
+
+		uint64_t size;
+		FILETIME lastWriteTime;
+		if ( GetFileState( hFile, size, lastWriteTime ) )
+		{
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				if ( auto it = knownFiles.find( lpFileName ); it != knownFiles.end() )
+				{
+					known = it->second;
+				}
+			}
+
+			// Seed from disk on first access, or if the file has been changed behind our back.
+			// Done without holding the lock, so other saves don't have to wait for the disk
+			if ( known == nullptr || known->contents.size() != size || CompareFileTime( &known->lastWriteTime, &lastWriteTime ) != 0 )
+			{
+				known = ReadFromDisk( hFile, size, lastWriteTime );
+			}
+		}
+
+		if ( known == nullptr )
+		{
+			// Couldn't figure out what's on disk, so fall back to the original behaviour
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				knownFiles.erase( lpFileName );
+			}
+			CloseHandle( hFile );
+
+			HANDLE result = CreateFileW( lpFileName, dwDesiredAccess, dwShareMode, lpSecurityAttributes, dwCreationDisposition, dwFlagsAndAttributes, hTemplateFile );
+			if ( result != INVALID_HANDLE_VALUE )
+			{
+				// The file might have been created by the first open
+				SetLastError( lastError );
+			}
+			return result;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+			knownFiles.insert_or_assign( lpFileName, known );
+			pendingWrites.insert_or_assign( hFile, PendingWrite{ lpFileName, std::move(known) } );
+		}
+
+		SetLastError( lastError );
+		return hFile;
+	}
+
+	// Writes matching the contents already on disk are only buffered. The first write that differs puts everything
+	// buffered so far on disk and then goes through as is, so the game gets to see its result like it used to
+	BOOL WINAPI WriteFileBuffered( HANDLE hFile, LPCVOID lpBuffer, DWORD nNumberOfBytesToWrite, LPDWORD lpNumberOfBytesWritten, LPOVERLAPPED lpOverlapped )
+	{
+		using namespace internal;
+
+		std::lock_guard<std::mutex> lock( mutex );
+
+		auto it = pendingWrites.find( hFile );
+		if ( it == pendingWrites.end() )
+		{
+			return WriteFile( hFile, lpBuffer, nNumberOfBytesToWrite, lpNumberOfBytesWritten, lpOverlapped );
+		}
+
+		// Overlapped writes would go around the buffer
+		if ( lpOverlapped != nullptr )
+		{
+			SetLastError( ERROR_INVALID_PARAMETER );
+			return FALSE;
+		}
+
+		if ( nNumberOfBytesToWrite == 0 )
+		{
+			*lpNumberOfBytesWritten = 0;
+			return TRUE;
+		}
+
+		PendingWrite& pending = it->second;
+
+		// Keep the real file pointer in sync, so seeks issued by the game keep working
+		LARGE_INTEGER position;
+		if ( SetFilePointerEx( hFile, LARGE_INTEGER{}, &position, FILE_CURRENT ) == FALSE )
+		{
+			pending.failed = true;
+			return FALSE;
+		}
+		const size_t offset = static_cast<size_t>(position.QuadPart);
+
+		if ( !pending.diverged )
+		{
+			const std::vector<uint8_t>& known = pending.known->contents;
+			if ( offset + nNumberOfBytesToWrite <= known.size() && memcmp( known.data() + offset, lpBuffer, nNumberOfBytesToWrite ) == 0 )
+			{
+				LARGE_INTEGER distance;
+				distance.QuadPart = nNumberOfBytesToWrite;
+				if ( SetFilePointerEx( hFile, distance, nullptr, FILE_CURRENT ) == FALSE )
+				{
+					pending.failed = true;
+					return FALSE;
+				}
+
+				StoreContents( pending.contents, offset, lpBuffer, nNumberOfBytesToWrite );
+				*lpNumberOfBytesWritten = nNumberOfBytesToWrite;
+				return TRUE;
+			}
+
+			// Contents are changing - bring the file to what the original CREATE_ALWAYS + writes so far would have left
+			pending.diverged = true;
+			knownFiles.erase( pending.path );
+			if ( !WriteContents( hFile, pending.contents ) || SetFilePointerEx( hFile, position, nullptr, FILE_BEGIN ) == FALSE )
+			{
+				pending.failed = true;
+				return FALSE;
+			}
+		}
+
+		DWORD bytesWritten;
+		const BOOL result = WriteFile( hFile, lpBuffer, nNumberOfBytesToWrite, &bytesWritten, nullptr );
+		if ( result != FALSE )
+		{
+			// Keep track of the new contents, so the next save can be compared against them without reading the file
+			StoreContents( pending.contents, offset, lpBuffer, bytesWritten );
+		}
+		else
+		{
+			pending.failed = true;
+		}
+		*lpNumberOfBytesWritten = bytesWritten;
+		return result;
+	}
+
+	BOOL CloseFile( HANDLE hObject )
+	{
+		using namespace internal;
+
+		std::optional<PendingWrite> pending;
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+			if ( auto it = pendingWrites.find( hObject ); it != pendingWrites.end() )
+			{
+				pending = std::move( it->second );
+				pendingWrites.erase( it );
+			}
+		}
+
+		if ( !pending )
+		{
+			return CloseHandle( hObject );
+		}
+
+		if ( pending->failed )
+		{
+			// The game has already been told about this from WriteFileBuffered, just make sure the file is read again next time
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				knownFiles.erase( pending->path );
+			}
+			return CloseHandle( hObject );
+		}
+
+		const uint64_t hash = HashContents( pending->contents );
+		if ( !pending->diverged )
+		{
+			if ( hash == pending->known->hash && pending->contents.size() == pending->known->contents.size() )
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				WritesAvoided++;
+				BytesAvoided += pending->contents.size();
+
+#if _DEBUG
+				wchar_t buf[512];
+				swprintf_s( buf, L"SilentPatch: Skipped unchanged write to %s (%llu writes, %llu bytes avoided so far)\n",
+					pending->path.c_str(), WritesAvoided, BytesAvoided );
+				OutputDebugStringW( buf );
+#endif
+				return CloseHandle( hObject );
+			}
+
+			// Every write matched, but the file ended up shorter than before - there is no write left
+			// to report a failure from, so tell the user directly
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				knownFiles.erase( pending->path );
+			}
+			if ( !WriteContents( hObject, pending->contents ) )
+			{
+				const DWORD writeError = GetLastError();
+				CloseHandle( hObject );
+
+				std::wstring message( L"Failed to write the following file:\n\n" );
+				message.append( pending->path );
+				message.append( L"\n\nThe file might be incomplete." );
+				MessageBoxW( nullptr, message.c_str(), L"SilentPatch", MB_OK|MB_ICONERROR|MB_SETFOREGROUND );
+
+				SetLastError( writeError );
+				return FALSE;
+			}
+		}
+
+		if ( CloseHandle( hObject ) == FALSE )
+		{
+			return FALSE;
+		}
+
+		// File times get updated on close, so only query them now
+		uint64_t size;
+		FILETIME lastWriteTime;
+		if ( GetFileState( pending->path.c_str(), size, lastWriteTime ) && size == pending->contents.size() )
+		{
+			auto written = std::make_shared<FileContents>();
+			written->hash = hash;
+			written->lastWriteTime = lastWriteTime;
+			written->contents = std::move( pending->contents );
+
+			std::lock_guard<std::mutex> lock( mutex );
+			knownFiles.insert_or_assign( pending->path, std::move(written) );
+		}
+		return TRUE;
+	}
+
+	void GetStats( uint64_t& writesAvoided, uint64_t& bytesAvoided )
+	{
+		std::lock_guard<std::mutex> lock( internal::mutex );
+		writesAvoided = internal::WritesAvoided;
+		bytesAvoided = internal::BytesAvoided;
+	}
+
+	auto* const pWriteFileBuffered = &WriteFileBuffered;
+}
+
 namespace FSFix
 {
 	namespace internal
@@ -331,6 +875,18 @@ namespace FSFix
 			return result;
 		}
 
+		HANDLE WINAPI CreateFileForWriteUTF8( LPCSTR utfFileName, DWORD dwDesiredAccess, DWORD dwShareMode, LPSECURITY_ATTRIBUTES lpSecurityAttributes, DWORD dwCreationDisposition, DWORD dwFlagsAndAttributes, HANDLE hTemplateFile )
+		{
+			int requiredSize = MultiByteToWideChar( CP_UTF8, 0, utfFileName, -1, nullptr, 0 );
+			wchar_t* wideBuffer = static_cast<wchar_t*>(_malloca( sizeof(wideBuffer[0]) * requiredSize ));
+			MultiByteToWideChar( CP_UTF8, 0, utfFileName, -1, wideBuffer, requiredSize );
+
+			HANDLE result = UnchangedWriteFix::CreateFileForWrite( wideBuffer, dwDesiredAccess, dwShareMode, lpSecurityAttributes, dwCreationDisposition, dwFlagsAndAttributes, hTemplateFile );
+
+			_freea( wideBuffer );
+			return result;
+		}
+
 		BOOL WINAPI CloseHandleChecked( HANDLE hObject )
 		{
 			BOOL result = TRUE;
@@ -340,10 +896,22 @@ namespace FSFix
 			}
 			return result;
 		}
+
+		BOOL WINAPI CloseFileChecked( HANDLE hObject )
+		{
+			BOOL result = TRUE;
+			if ( hObject != INVALID_HANDLE_VALUE )
+			{
+				result = UnchangedWriteFix::CloseFile( hObject );
+			}
+			return result;
+		}
 	}
 
 	auto* const pCreateFileUTF8 = &internal::CreateFileUTF8;
+	auto* const pCreateFileForWriteUTF8 = &internal::CreateFileForWriteUTF8;
 	auto* const pCloseHandleChecked = &internal::CloseHandleChecked;
+	auto* const pCloseFileChecked = &internal::CloseFileChecked;
 
 	BOOL CreateDirectoryRecursivelyUTF8( LPCSTR utfDirName )
 	{
@@ -473,6 +1041,41 @@ static void InitASI()
 		}
 
 
+		// Writes to GraphicOption and MGR.sav are held back for as long as they match what's already on disk,
+		// so saving without changing anything doesn't rewrite the file
+		// (every rewrite triggers a re-upload on cloud synced Documents directories)
+		bool skipUnchangedWrites = false;
+		if ( int skipWrites = GetPrivateProfileIntW( L"SilentPatch", L"SkipUnchangedWrites", -1, GetINIPath().c_str() ); skipWrites != -1 )
+		{
+			skipUnchangedWrites = skipWrites != 0;
+		}
+
+		// Patches a CreateFile ... WriteFile ... CloseHandle sequence, routing it through UnchangedWriteFix only if its WriteFile calls can be found
+		auto patchFileWrite = [skipUnchangedWrites]( uint8_t* createFile, uint8_t* closeHandle )
+		{
+			std::vector<void*> writeFileCalls;
+			if ( skipUnchangedWrites )
+			{
+				writeFileCalls = UnchangedWriteFix::internal::FindWriteFileCalls( createFile + 6, closeHandle );
+			}
+
+			if ( !writeFileCalls.empty() )
+			{
+				Patch( createFile + 2, &pCreateFileForWriteUTF8 );
+				for ( void* writeFile : writeFileCalls )
+				{
+					Patch( writeFile, &UnchangedWriteFix::pWriteFileBuffered );
+				}
+				Patch( closeHandle + 2, &pCloseFileChecked );
+			}
+			else
+			{
+				Patch( createFile + 2, &pCreateFileUTF8 );
+				Patch( closeHandle + 2, &pCloseHandleChecked );
+			}
+		};
+
+
 		// WriteGraphicsOptions:
 		{
 			auto writeGraphicsOptions = pattern( "68 00 01 00 00 50 E8 ? ? ? ? 8D 4C 24 28 51 E8" ).get_one();
@@ -483,10 +1086,8 @@ static void InitASI()
 			// sprintf_s replaced with a function to append GraphicOption
 			InjectHook( writeGraphicsOptions.get<void>( 0x43 ), sprintf_AppendGraphicsOption );
 
-			Patch( writeGraphicsOptions.get<void>( 0x62 + 2 ), &pCreateFileUTF8 );
-
-			// Don't close invalid handles
-			Patch( writeGraphicsOptions.get<void>( 0x8C + 2 ), &pCloseHandleChecked );
+			// CreateFile replaced with a UTF-8 version, don't close invalid handles
+			patchFileWrite( writeGraphicsOptions.get<uint8_t>( 0x62 ), writeGraphicsOptions.get<uint8_t>( 0x8C ) );
 		}
 
 		
@@ -525,11 +1126,9 @@ static void InitASI()
 			// sprintf_s replaced with a function to append MGR.sav (from argument)
 			InjectHook( dataSave.get<void>( 0x47 ), sprintf_AppendFormatArgument );
 
-			Patch( dataSave.get<void>( 0x4C + 2 ), &pCreateFileUTF8 );
-			Patch( dataSave.get<void>( 0x1BA + 2 ), &pCreateFileUTF8 );
-
-			Patch( dataSave.get<void>( 0x19A + 2 ), &pCloseHandleChecked );
-			Patch( dataSave.get<void>( 0x264 + 2 ), &pCloseHandleChecked );
+			// CreateFile replaced with a UTF-8 version, don't close invalid handles
+			patchFileWrite( dataSave.get<uint8_t>( 0x4C ), dataSave.get<uint8_t>( 0x19A ) );
+			patchFileWrite( dataSave.get<uint8_t>( 0x1BA ), dataSave.get<uint8_t>( 0x264 ) );
 		}
 
 
@@ -651,4 +1250,9 @@ extern "C"
 		if ( _InterlockedCompareExchange( &InitCount, 1, 0 ) != 0 ) return;
 		InitASI();
 	}
+
+	__declspec(dllexport) void GetUnchangedWriteStats( uint64_t* writesAvoided, uint64_t* bytesAvoided )
+	{
+		UnchangedWriteFix::GetStats( *writesAvoided, *bytesAvoided );
+	}
 }